@@ -1,3 +1,7 @@
+#include <fcntl.h>
+#include <libgen.h>
+#include <unistd.h>
+
 #include "io.h"
 
 size_t countLines( FILE* file ) {
@@ -133,4 +137,105 @@ size_t readData( const size_t numThermal, int nlambda, char** sfNames, double**
     offset += lengths[numLambda];
   }  
   return offset;
-}
\ No newline at end of file
+}
+
+static const char checkpointMagic[8] = "MHRWCKP2";
+
+/* Flushes the Binned files to disk and records their lengths, then writes the
+ * checkpoint to filename.tmp and renames it, so an interruption while writing
+ * never destroys the previous checkpoint.
+ */
+void writeCheckpoint( const char* filename, struct checkpoint * const cp, FILE** files, double** errs, const size_t numErrs, gsl_rng const * const r ) {
+  for( size_t k = 0; k < cp->numFiles; ++k ) {
+    if( fflush( files[k] ) != 0 || fsync( fileno( files[k] ) ) != 0 ) {
+      puts( "ERROR: could not flush bootstrap samples to disk." );
+      exit(1);
+    }
+    cp->fileOffsets[k] = ftell( files[k] );
+  }
+  
+  char tmpname[strlen( filename ) + 5];
+  strcpy( tmpname, filename );
+  strcat( tmpname, ".tmp" );
+  
+  FILE* file = fopen( tmpname, "wb" );
+  if( file == NULL ) {
+    printf("ERROR: could not open checkpoint file for writing: %s\n", tmpname);
+    exit(1);
+  }
+  
+  size_t header[] = { cp->boot, cp->nlambda, cp->len_total, cp->bin_size, cp->numInterpol, cp->numFiles, cp->L, cp->numThermal };
+  double params[] = { cp->f0, cp->lam_min, cp->lam_max };
+  int ok = fwrite( checkpointMagic, sizeof checkpointMagic, 1, file ) == 1
+        && fwrite( header, sizeof header, 1, file ) == 1
+        && fwrite( params, sizeof params, 1, file ) == 1
+        && fwrite( cp->fileOffsets, sizeof *cp->fileOffsets, cp->numFiles, file ) == cp->numFiles;
+  for( size_t k = 0; ok && k < numErrs; ++k ) {
+    ok = fwrite( errs[k], sizeof *errs[k], cp->numInterpol, file ) == cp->numInterpol;
+  }
+  ok = ok && gsl_rng_fwrite( file, r ) == GSL_SUCCESS;
+  ok = ok && writeSolverState( file ) == GSL_SUCCESS;
+  ok = ok && fflush( file ) == 0 && fsync( fileno( file ) ) == 0;
+  ok = ( fclose( file ) == 0 ) && ok;
+  
+  if( !ok || rename( tmpname, filename ) != 0 ) {
+    printf("ERROR: writing checkpoint file %s failed.\n", filename);
+    exit(1);
+  }
+  
+  // the rename is only durable once the containing directory is synced
+  char dirpath[strlen( filename ) + 1];
+  strcpy( dirpath, filename );
+  int dir = open( dirname( dirpath ), O_RDONLY );
+  if( dir < 0 || fsync( dir ) != 0 ) {
+    printf("ERROR: could not sync directory of checkpoint file %s.\n", filename);
+    exit(1);
+  }
+  close( dir );
+}
+
+void readCheckpoint( const char* filename, struct checkpoint * const cp, double** errs, const size_t numErrs, gsl_rng* const r ) {
+  FILE* file = fopen( filename, "rb" );
+  if( file == NULL ) {
+    printf("ERROR: checkpoint file not found for resume: %s\n", filename);
+    exit(1);
+  }
+  
+  char magic[sizeof checkpointMagic];
+  size_t header[8];
+  double params[3];
+  if( fread( magic, sizeof magic, 1, file ) != 1 || memcmp( magic, checkpointMagic, sizeof magic ) != 0
+   || fread( header, sizeof header, 1, file ) != 1 || fread( params, sizeof params, 1, file ) != 1 ) {
+    printf("ERROR: %s is not a valid checkpoint file.\n", filename);
+    exit(1);
+  }
+  
+  size_t current[] = { 0, cp->nlambda, cp->len_total, cp->bin_size, cp->numInterpol, cp->numFiles, cp->L, cp->numThermal };
+  double currentParams[] = { cp->f0, cp->lam_min, cp->lam_max };
+  if( memcmp( header+1, current+1, sizeof header - sizeof *header ) != 0 || memcmp( params, currentParams, sizeof params ) != 0 ) {
+    const char* names[] = { "N_boot", "nlambda", "len_total", "bin_size", "N_interpol", "numFiles", "L", "N_thermal" };
+    const char* paramNames[] = { "f0", "lam_min", "lam_max" };
+    puts( "ERROR in readCheckpoint: checkpoint was written for different input (checkpoint / current):" );
+    for( size_t i = 1; i < 8; ++i ) {
+      printf( "  %-10s %zu / %zu%s\n", names[i], header[i], current[i], header[i] != current[i] ? "  <--" : "" );
+    }
+    for( size_t i = 0; i < 3; ++i ) {
+      printf( "  %-10s %.10f / %.10f%s\n", paramNames[i], params[i], currentParams[i], params[i] != currentParams[i] ? "  <--" : "" );
+    }
+    exit(1);
+  }
+  cp->boot = header[0];
+  
+  int ok = fread( cp->fileOffsets, sizeof *cp->fileOffsets, cp->numFiles, file ) == cp->numFiles;
+  for( size_t k = 0; ok && k < numErrs; ++k ) {
+    ok = fread( errs[k], sizeof *errs[k], cp->numInterpol, file ) == cp->numInterpol;
+  }
+  ok = ok && gsl_rng_fread( file, r ) == GSL_SUCCESS;
+  ok = ok && readSolverState( file, cp->nlambda ) == GSL_SUCCESS;
+  fclose( file );
+  
+  if( !ok ) {
+    printf("ERROR: checkpoint file %s is truncated or corrupt.\n", filename);
+    exit(1);
+  }
+}
@@ -4,6 +4,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <gsl/gsl_rng.h>
+
+#include "solver.h"
 
 size_t countLines( FILE* file );
 
@@ -15,4 +18,26 @@ int readOnConfigFile( const size_t numThermal, char* filename, double** secondCo
 
 size_t readData( const size_t numThermal, int nlambda, char** sfNames, double** sfVals, char** actionNames, double** actionVals, int* length );
 
+/* State of an interrupted bootstrap run, see writeCheckpoint/readCheckpoint.
+ * All input parameters except N_boot are stored to refuse resuming with inconsistent input.
+ */
+struct checkpoint {
+  size_t boot;            // number of completed bootstrap samples
+  size_t nlambda;
+  size_t len_total;
+  size_t bin_size;
+  size_t numInterpol;
+  size_t numFiles;
+  size_t L;
+  size_t numThermal;
+  double f0;
+  double lam_min;
+  double lam_max;
+  long* fileOffsets;      // length of each Binned*.dat file after sample boot-1
+};
+
+void writeCheckpoint( const char* filename, struct checkpoint * const cp, FILE** files, double** errs, const size_t numErrs, gsl_rng const * const r );
+
+void readCheckpoint( const char* filename, struct checkpoint * const cp, double** errs, const size_t numErrs, gsl_rng* const r );
+
 #endif
\ No newline at end of file
@@ -1,18 +1,43 @@
 #include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
 #include <math.h>
 #include <gsl/gsl_vector.h>
 #include <gsl/gsl_multiroots.h>
+#include <gsl/gsl_rng.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "io.h"
 #include "single_run.h"
 
 int main( int argc, char** argv ) {
-  if( argc != 13 ) {
-    printf( "ERROR: Need 12 input parameters: lambdas.txt sf_paths.txt action_paths.txt subfolder_name L N_boot, bin_size, N_thermal, f0-shift, N_interpol, lam_min, lam_max\n" );
+  if( argc < 13 ) {
+    printf( "ERROR: Need 12 input parameters: lambdas.txt sf_paths.txt action_paths.txt subfolder_name L N_boot, bin_size, N_thermal, f0-shift, N_interpol, lam_min, lam_max [--checkpoint N_samples] [--resume]\n" );
     exit(1);
   }
   
+  // optional arguments: checkpoint the bootstrap every N samples and resume from the last checkpoint
+  size_t checkpointEvery = 10;
+  int resume = 0;
+  for( int arg = 13; arg < argc; ++arg ) {
+    if( strcmp( argv[arg], "--resume" ) == 0 ) {
+      resume = 1;
+    } else if( strcmp( argv[arg], "--checkpoint" ) == 0 && arg+1 < argc ) {
+      char* end;
+      errno = 0;
+      unsigned long every = strtoul( argv[++arg], &end, 10 );
+      if( !isdigit( (unsigned char) argv[arg][0] ) || *end != '\0' || errno != 0 || every == 0 ) {
+        printf( "ERROR: --checkpoint needs a positive integer, got %s\n", argv[arg] );
+        exit(1);
+      }
+      checkpointEvery = every;
+    } else {
+      printf( "ERROR: unknown or incomplete option %s\n", argv[arg] );
+      exit(1);
+    }
+  }
+  
   if( sizeof(double) >= sizeof(long double) ){
     printf("WARNING: long double seems no longer than double: %lu, long double: %lu", sizeof(double), sizeof(long double));
   }
@@ -69,7 +94,8 @@ int main( int argc, char** argv ) {
   single_run( V, &p, sfVals, numInterpol, ip_lam, lam_min, lam_max, ip_sfabs, ip_sus, ip_bc, ip_dlog );
   
   // binning and bootstrapping for error estimates
-  srand(time(0));
+  gsl_rng* r = gsl_rng_alloc( gsl_rng_mt19937 );
+  gsl_rng_set( r, time(0) );
   size_t Nboot = atoi(argv[6]);
   size_t bin_size = atoi(argv[7]);
   
@@ -97,7 +123,56 @@ int main( int argc, char** argv ) {
   filenames[3] = "/BinnedDLogScalarField.dat";
   FILE* files[numObservables];
   
-  for( size_t k = 0; k < numObservables; ++k ) {
+  double* errs[] = { err_sfabs, err_sus, err_bc, err_dlog };
+  long fileOffsets[numObservables];
+  struct checkpoint cp = {
+    0,
+    nlambda,
+    len_total,
+    bin_size,
+    numInterpol,
+    numObservables,
+    L,
+    numThermal,
+    f0,
+    lam_min,
+    lam_max,
+    fileOffsets
+  };
+  char checkpointPath[80] = { 0 };
+  strcat( checkpointPath, argv[4] );
+  strcat( checkpointPath, "/Checkpoint.dat" );
+  
+  // restores error accumulators, RNG state and the warm-start f_a of the last completed sample
+  if( resume ) {
+    readCheckpoint( checkpointPath, &cp, errs, numObservables, r );
+    printf( "Resuming after %zu completed bootstrap samples.\n", cp.boot );
+    if( cp.boot > Nboot ) {
+      printf( "ERROR: checkpoint already contains %zu bootstrap samples, more than N_boot=%zu.\n", cp.boot, Nboot );
+      exit(1);
+    }
+  }
+  
+  for( size_t k = 0; k < numObservables && resume; ++k ) {
+    char outpath[80] = { 0 };
+    strcat( outpath, argv[4] );
+    strcat( outpath, filenames[k] );
+    files[k] = fopen( outpath, "r+" );
+    // drop samples written after the checkpoint, they are recomputed identically
+    if( files[k] == NULL || fseek( files[k], 0, SEEK_END ) != 0 || ftell( files[k] ) < fileOffsets[k]
+     || ftruncate( fileno( files[k] ), fileOffsets[k] ) != 0 || fseek( files[k], fileOffsets[k], SEEK_SET ) != 0 ) {
+      printf( "ERROR: could not restore %s to the state of the checkpoint.\n", outpath );
+      exit(1);
+    }
+  }
+  
+  // a checkpoint left over from an earlier run must never be resumed into this one
+  if( !resume && remove( checkpointPath ) != 0 && errno != ENOENT ) {
+    printf( "ERROR: could not remove old checkpoint file %s\n", checkpointPath );
+    exit(1);
+  }
+  
+  for( size_t k = 0; k < numObservables && !resume; ++k ) {
     char outpath[80] = { 0 };
     strcat( outpath, argv[4] );
     strcat( outpath, filenames[k] );
@@ -114,9 +189,13 @@ int main( int argc, char** argv ) {
     fprintf( files[k], "\n");
   }
   
-  for( size_t boot = 0; boot < Nboot; ++boot ) {
+  if( !resume ) {
+    writeCheckpoint( checkpointPath, &cp, files, errs, numObservables, r );
+  }
+  
+  for( size_t boot = cp.boot; boot < Nboot; ++boot ) {
     printf( "Calculating bootstrap sample %zu...\n", boot );
-    random_select( actionVals, sfVals, lengths, nlambda, bin_size, actionSelect, sfSelect );
+    random_select( r, actionVals, sfVals, lengths, nlambda, bin_size, actionSelect, sfSelect );
     single_run( V, &p, sfSelect, numInterpol, ip_lam, lam_min, lam_max, bin_ip_sfabs, bin_ip_sus, bin_ip_bc, bin_ip_dlog );
     
     for( size_t ip = 0; ip < numInterpol; ++ip ) {
@@ -134,6 +213,11 @@ int main( int argc, char** argv ) {
     for( size_t k = 0; k < numObservables; ++k ) {
       fprintf( files[k], "\n");
     }
+    
+    if( (boot+1) % checkpointEvery == 0 || boot+1 == Nboot ) {
+      cp.boot = boot+1;
+      writeCheckpoint( checkpointPath, &cp, files, errs, numObservables, r );
+    }
   }
   
   for( size_t k = 0; k < numObservables; ++k ) {
@@ -182,6 +266,7 @@ int main( int argc, char** argv ) {
   free( err_dlog );
   
   free( lambdas );
+  gsl_rng_free( r );
   freeSolver();
   
   return EXIT_SUCCESS;
@@ -1,26 +1,6 @@
 #include "single_run.h"
 
-/* Returns an integer in the range [0, n).
- * Uses rand(), and so is affected-by/affects the same seed.
- * see: http://stackoverflow.com/questions/822323/how-to-generate-a-random-number-in-c
- */
-size_t randint(size_t n) {
-  if ((n - 1) == RAND_MAX) {
-    return rand();
-  } else {
-    // Chop off all of the values that would cause skew...
-    long end = RAND_MAX / n; // truncate skew
-    end *= n;
-
-    // ... and ignore results from rand() that fall above that limit.
-    size_t r;
-    while ((r = rand()) >= end);
-
-    return r % n;
-  }
-}
-
-void random_select( double const * const actionVals, double const * const sfVals, int* lengths, size_t nlambda,        size_t bin_size, double* actionSelect, double* sfSelect) {
+void random_select( gsl_rng* r, double const * const actionVals, double const * const sfVals, int* lengths, size_t nlambda,        size_t bin_size, double* actionSelect, double* sfSelect) {
   
   size_t offset = 0;
   
@@ -32,7 +12,7 @@ void random_select( double const * const actionVals, double const * const sfVals
     }
     
     for( size_t b = 0; b < num_bins; ++b ) {
-      size_t bin_idx = randint( num_bins );
+      size_t bin_idx = gsl_rng_uniform_int( r, num_bins );
       
       memcpy( actionSelect + offset + b * bin_size
             , actionVals + offset + bin_idx * bin_size
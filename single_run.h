@@ -2,12 +2,12 @@
 #define SINGLE_RUN_H
 
 #include <string.h>
+#include <gsl/gsl_rng.h>
 #include "solver.h"
 #include "observables.h"
 
-size_t randint( size_t max );
-
-void random_select( double const * const actionVals
+void random_select( gsl_rng* r
+                  , double const * const actionVals
                   , double const * const sfVals
                   , int* lengths
                   , size_t nlambda
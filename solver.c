@@ -121,4 +121,21 @@ void calcSolution( struct rparams * params, double* sol ) {
 void freeSolver() {
   gsl_vector_free( fa );
 }
+
+int writeSolverState( FILE* file ) {
+  if( fa == NULL ) {
+    return GSL_EFAILED;
+  }
+  return gsl_vector_fwrite( file, fa );
+}
+
+int readSolverState( FILE* file, const size_t nlambda ) {
+  if( fa == NULL ) {
+    fa = gsl_vector_alloc( nlambda-1 );
+  }
+  if( fa->size != nlambda-1 ) {
+    return GSL_EBADLEN;
+  }
+  return gsl_vector_fread( file, fa );
+}
   
\ No newline at end of file
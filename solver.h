@@ -25,4 +25,9 @@ void calcSolution( struct rparams * params, double* sol );
 
 void freeSolver();
 
+// (de)serialise the warm-start vector of f_a used as initial guess by calcSolution
+int writeSolverState( FILE* file );
+
+int readSolverState( FILE* file, const size_t nlambda );
+
 #endif
\ No newline at end of file